@@ -1,3 +1,6 @@
+#ifndef LAYER_c
+#define LAYER_c
+
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -64,6 +67,7 @@ typedef struct {
     Matrix z_prime;
     Matrix t_input;
     Matrix buffer;
+    Matrix mask;     // Masque d'élagage (1 = poids conservé, 0 = poids élagué), data == NULL si non élaguée
     int use_softmax; // Flag pour indiquer si cette couche est une couche de sortie avec softmax
 } Layer;
 
@@ -113,6 +117,7 @@ Layer create_layer(int input_size, int output_size, ActivationFunc activation, i
     layer.z_prime = create_matrix(1, output_size, 0);
     layer.t_input = create_matrix(input_size, 1, 0);
     layer.buffer = create_matrix(input_size, output_size, 0);
+    layer.mask = (Matrix){input_size, output_size, NULL}; // Alloué seulement lors de l'élagage
     layer.use_softmax = use_softmax;
 
     return layer;
@@ -132,6 +137,7 @@ void free_layer(Layer *layer) {
     free_matrix(&layer->z_prime);
     free_matrix(&layer->t_input);
     free_matrix(&layer->buffer);
+    free_matrix(&layer->mask);
 }
 
 void apply_softmax(Layer *layer) {
@@ -178,6 +184,8 @@ void forward_layer(Layer *layer, Matrix input) {
 }
 
 void compute_z_prime(Layer *layer) {
+    // Softmax : pas de dérivée, le delta est calculé directement dans train_network
+    if (layer->deriv == NULL) return;
     for (int i = 0; i < layer->z.rows; i++) {
         for (int j = 0; j < layer->z.cols; j++) {
             double z_val = get_element(layer->z, i, j);
@@ -186,9 +194,38 @@ void compute_z_prime(Layer *layer) {
     }
 }
 
+// Élagage par magnitude : met à zéro tous les poids tels que |w| <= threshold
+// et mémorise le masque pour que l'entraînement ne les réactive pas.
+// Retourne le nombre de poids élagués.
+int prune_layer(Layer *layer, double threshold) {
+    if (layer->mask.data == NULL) {
+        layer->mask = create_matrix(layer->weights.rows, layer->weights.cols, 0);
+    }
+    int pruned = 0;
+    for (int i = 0; i < layer->weights.rows * layer->weights.cols; i++) {
+        if (fabs(layer->weights.data[i]) <= threshold) {
+            layer->weights.data[i] = 0.0;
+            layer->mask.data[i] = 0.0;
+            pruned++;
+        } else {
+            layer->mask.data[i] = 1.0;
+        }
+    }
+    transpose_matrix(layer->weights, layer->t_weights); // Garder la transposée cohérente
+    return pruned;
+}
+
+// Réapplique le masque d'élagage après une mise à jour des poids
+void apply_mask(Layer *layer) {
+    if (layer->mask.data == NULL) return;
+    elementwise_multiply_matrix(layer->weights, layer->mask, layer->weights);
+}
+
 void print_layer(Layer layer) { 
     printf("Poids :\n"); 
     print_matrix(layer.weights); 
     printf("Biais :\n"); 
     print_matrix(layer.biases);
-}
\ No newline at end of file
+}
+
+#endif
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include <stdlib.h>
 #include <time.h>
 #include "network.c"
+#include "sparse.c"
 #include "mnist.c"
 
 // Fonction utilitaire pour trouver l'index de la valeur max (argmax)
@@ -18,6 +19,60 @@ int argmax(Matrix m) {
     return max_index;
 }
 
+// Une epoch d'entraînement, retourne la précision obtenue pendant l'epoch
+// label : préfixe de la ligne de progression (ex. "Epoch 2", "Fine-tuning 90%")
+double train_epoch(Network *net, Matrix *inputs, Matrix *targets, int count, double learning_rate, int batch_size, int *batch_counter, const char *label) {
+    int correct_predictions = 0;
+
+    // Mélanger les données serait mieux ici (Shuffle), mais on fait simple pour l'instant
+    for (int i = 0; i < count; i++) {
+        
+        // Entraînement
+        *batch_counter = train_network(net, inputs[i], targets[i], learning_rate, batch_size, *batch_counter);
+
+        // Calcul de précision (juste pour l'affichage, on refait un forward rapide)
+        // Note: C'est couteux de refaire forward, mais utile pour voir la progression
+        Matrix output = create_matrix(1, 10, 0);
+        forward_network(*net, inputs[i], output);
+        
+        int prediction = argmax(output);
+        int target = argmax(targets[i]);
+        
+        if (prediction == target) {
+            correct_predictions++;
+        }
+        free_matrix(&output);
+
+        if (i % 1000 == 0 && i > 0) {
+            printf("%s, Image %d/%d, Précision courante: %.2f%%\r", 
+                   label, i, count, (double)correct_predictions/i * 100.0);
+            fflush(stdout);
+        }
+    }
+    return (double)correct_predictions/count * 100.0;
+}
+
+// Précision (en %) et durée d'inférence (en secondes) sur un jeu de données
+// sparse == NULL : inférence dense, sinon inférence creuse
+double evaluate(Network net, SparseNetwork *sparse, Matrix *inputs, Matrix *targets, int count, double *seconds) {
+    Matrix output = create_matrix(1, 10, 0);
+    int correct = 0;
+    clock_t start = clock();
+    for (int i = 0; i < count; i++) {
+        if (sparse) {
+            forward_sparse_network(*sparse, inputs[i], output);
+        } else {
+            forward_network(net, inputs[i], output);
+        }
+        if (argmax(output) == argmax(targets[i])) {
+            correct++;
+        }
+    }
+    *seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    free_matrix(&output);
+    return (double)correct / count * 100.0;
+}
+
 int main() {
     srand(time(NULL));
 
@@ -30,6 +85,13 @@ int main() {
                &train_inputs, &train_targets, &train_count);
     train_count = 10000; // Pour accélérer les tests, on limite à 10k images (au lieu de 60k)
 
+    // Jeu de test séparé : la précision après élagage doit être mesurée sur des
+    // images jamais vues, pas sur celles qui servent au fine-tuning
+    Matrix *test_inputs, *test_targets;
+    int test_count;
+    load_mnist("data/t10k-images-idx3-ubyte", "data/t10k-labels-idx1-ubyte",
+               &test_inputs, &test_targets, &test_count);
+
     // 2. Création du réseau
     // 784 entrées (pixels) -> 128 cachés -> 10 sorties (chiffres 0-9)
     int layers[] = {784, 128, 10};
@@ -45,39 +107,74 @@ int main() {
 
     printf("Début de l'entraînement sur %d images...\n", train_count);
 
+    char label[64];
     for (int e = 0; e < epochs; e++) {
-        double total_error = 0;
-        int correct_predictions = 0;
-
-        // Mélanger les données serait mieux ici (Shuffle), mais on fait simple pour l'instant
-        for (int i = 0; i < train_count; i++) {
-            
-            // Entraînement
-            batch_counter = train_network(&net, train_inputs[i], train_targets[i], learning_rate, batch_size, batch_counter);
-
-            // Calcul de précision (juste pour l'affichage, on refait un forward rapide)
-            // Note: C'est couteux de refaire forward, mais utile pour voir la progression
-            Matrix output = create_matrix(1, 10, 0);
-            forward_network(net, train_inputs[i], output);
-            
-            int prediction = argmax(output);
-            int target = argmax(train_targets[i]);
-            
-            if (prediction == target) {
-                correct_predictions++;
-            }
-            free_matrix(&output);
+        snprintf(label, sizeof(label), "Epoch %d", e+1);
+        double accuracy = train_epoch(&net, train_inputs, train_targets, train_count, learning_rate, batch_size, &batch_counter, label);
+        printf("\nEpoch %d terminée. Précision finale: %.2f%%\n", e+1, accuracy);
+    }
+
+    // 4. Élagage par magnitude + inférence creuse
+    // Les niveaux sont croissants : chaque élagage part du réseau déjà élagué et fine-tuné.
+    // Le niveau 0 % exécute les noyaux creux sur le réseau non élagué : les accélérations
+    // sont calculées par rapport à cette ligne, pour ne mesurer que le gain dû à l'élagage
+    // (le noyau creux saute déjà les pixels nuls, contrairement à forward_network).
+    double sparsities[] = {0.0, 0.5, 0.8, 0.9, 0.95};
+    int num_sparsities = sizeof(sparsities) / sizeof(sparsities[0]);
+    int finetune_epochs = 1;
+    int global_pruning = 1;
+
+    double dense_time;
+    double dense_accuracy = evaluate(net, NULL, test_inputs, test_targets, test_count, &dense_time);
+    long dense_bytes = dense_network_bytes(net);
+    printf("\nRéseau dense (test) : précision %.2f%%, inférence %.3fs, taille %ld octets\n",
+           dense_accuracy, dense_time, dense_bytes);
 
-            if (i % 1000 == 0 && i > 0) {
-                printf("Epoch %d, Image %d/%d, Précision courante: %.2f%%\r", 
-                       e+1, i, train_count, (double)correct_predictions/i * 100.0);
-                fflush(stdout);
+    double csr_base_time = 0.0, bcsr_base_time = 0.0;
+    double achieved[num_sparsities], accuracies[num_sparsities], csr_speedups[num_sparsities], bcsr_speedups[num_sparsities];
+    long csr_bytes[num_sparsities], bcsr_bytes[num_sparsities];
+    for (int s = 0; s < num_sparsities; s++) {
+        achieved[s] = 0.0;
+        if (sparsities[s] > 0.0) {
+            achieved[s] = prune_network(&net, sparsities[s], global_pruning);
+
+            // Fine-tuning avec masque fixe (les poids élagués restent à zéro)
+            for (int e = 0; e < finetune_epochs; e++) {
+                snprintf(label, sizeof(label), "Fine-tuning %.0f%% (epoch %d)", sparsities[s] * 100.0, e+1);
+                train_epoch(&net, train_inputs, train_targets, train_count, learning_rate, batch_size, &batch_counter, label);
+                printf("\n");
             }
         }
-        printf("\nEpoch %d terminée. Précision finale: %.2f%%\n", e+1, (double)correct_predictions/train_count * 100.0);
+
+        SparseNetwork csr = create_sparse_network(&net, 1);
+        SparseNetwork bcsr = create_sparse_network(&net, SPARSE_BLOCK);
+        double csr_time, bcsr_time;
+        accuracies[s] = evaluate(net, &csr, test_inputs, test_targets, test_count, &csr_time);
+        evaluate(net, &bcsr, test_inputs, test_targets, test_count, &bcsr_time);
+        if (s == 0) {
+            csr_base_time = csr_time;
+            bcsr_base_time = bcsr_time;
+        }
+        csr_speedups[s] = csr_base_time / csr_time;
+        bcsr_speedups[s] = bcsr_base_time / bcsr_time;
+        csr_bytes[s] = sparse_network_bytes(csr);
+        bcsr_bytes[s] = sparse_network_bytes(bcsr);
+
+        free_sparse_network(&csr);
+        free_sparse_network(&bcsr);
+    }
+
+    // Tableau affiché après coup pour ne pas être entrecoupé par la progression du fine-tuning
+    printf("\nCSR à 0%% : %.3fs, BCSR(4) à 0%% : %.3fs (forward_network dense : %.3fs)\n",
+           csr_base_time, bcsr_base_time, dense_time);
+    printf("Sparsité | Précision (test) | Accél. CSR | Accél. BCSR(4) | Taille CSR | Taille BCSR(4)\n");
+    for (int s = 0; s < num_sparsities; s++) {
+        printf("%7.1f%% | %15.2f%% | %9.2fx | %13.2fx | %10ld | %14ld\n",
+               achieved[s] * 100.0, accuracies[s], csr_speedups[s], bcsr_speedups[s],
+               csr_bytes[s], bcsr_bytes[s]);
     }
 
-    // 4. Test rapide sur une image manuelle (optionnel)
+    // 5. Test rapide sur une image manuelle (optionnel)
     printf("\nTest sur la première image du set :\n");
     Matrix output = create_matrix(1, 10, 0);
     forward_network(net, train_inputs[0], output);
@@ -90,6 +187,7 @@ int main() {
     free_network(&net);
     free_matrix(&output);
     free_mnist_data(train_inputs, train_targets, train_count);
+    free_mnist_data(test_inputs, test_targets, test_count);
     
     return 0;
 }
\ No newline at end of file
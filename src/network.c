@@ -1,3 +1,6 @@
+#ifndef NETWORK_c
+#define NETWORK_c
+
 #include "layer.c"
 
 typedef struct {
@@ -109,6 +112,7 @@ int train_network(Network *net, Matrix input, Matrix target, double learning_rat
             scalar_multiply_matrix(l->weight_gradients, effective_lr, l->weight_gradients); // Scale les gradients par le learning rate
             substract_matrices(l->weights, l->weight_gradients, l->weights);
             reset_matrix(l->weight_gradients);
+            apply_mask(l); // Les poids élagués restent à zéro pendant le fine-tuning
             transpose_matrix(l->weights, l->t_weights); // Met à jour la transposée des poids pour la prochaine itération
 
             // B = B - (lr * Gradients)
@@ -122,6 +126,73 @@ int train_network(Network *net, Matrix input, Matrix target, double learning_rat
     return current_batch + 1;
 }
 
+static int compare_doubles(const void *a, const void *b) {
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Seuil tel qu'une fraction `sparsity` des valeurs |data[i]| soit <= seuil
+static double magnitude_threshold(double *data, int count, double sparsity) {
+    int k = (int)(sparsity * count);
+    if (k <= 0) return -1.0; // Rien à élaguer
+    if (k > count) k = count;
+
+    double *magnitudes = malloc(count * sizeof(double));
+    if (magnitudes == NULL) {
+        fprintf(stderr, "Erreur d'allocation mémoire !\n");
+        exit(1);
+    }
+    for (int i = 0; i < count; i++) {
+        magnitudes[i] = fabs(data[i]);
+    }
+    qsort(magnitudes, count, sizeof(double), compare_doubles);
+    double threshold = magnitudes[k - 1];
+    free(magnitudes);
+    return threshold;
+}
+
+// Élagage par magnitude de tous les poids du réseau (les biais ne sont pas élagués).
+// global = 1 : un seul seuil calculé sur l'ensemble des couches
+// global = 0 : chaque couche est élaguée à la même fraction `sparsity`
+// Retourne la sparsité effectivement obtenue.
+double prune_network(Network *net, double sparsity, int global) {
+    int total = 0;
+    int pruned = 0;
+
+    if (global) {
+        for (int i = 0; i < net->num_layers; i++) {
+            total += net->layers[i].weights.rows * net->layers[i].weights.cols;
+        }
+        double *all = malloc(total * sizeof(double));
+        if (all == NULL) {
+            fprintf(stderr, "Erreur d'allocation mémoire !\n");
+            exit(1);
+        }
+        int offset = 0;
+        for (int i = 0; i < net->num_layers; i++) {
+            Matrix w = net->layers[i].weights;
+            for (int j = 0; j < w.rows * w.cols; j++) {
+                all[offset++] = w.data[j];
+            }
+        }
+        double threshold = magnitude_threshold(all, total, sparsity);
+        free(all);
+        for (int i = 0; i < net->num_layers; i++) {
+            pruned += prune_layer(&net->layers[i], threshold);
+        }
+    } else {
+        for (int i = 0; i < net->num_layers; i++) {
+            Matrix w = net->layers[i].weights;
+            double threshold = magnitude_threshold(w.data, w.rows * w.cols, sparsity);
+            pruned += prune_layer(&net->layers[i], threshold);
+            total += w.rows * w.cols;
+        }
+    }
+
+    return (double)pruned / total;
+}
+
 void print_network(Network net){
 for(int i=0; i<net.num_layers; i++){ 
     printf("Couche %d :\n", i); 
@@ -130,3 +201,4 @@ for(int i=0; i<net.num_layers; i++){
     }      
 }
 
+#endif
\ No newline at end of file
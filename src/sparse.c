@@ -0,0 +1,204 @@
+#ifndef SPARSE_c
+#define SPARSE_c
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "network.c"
+
+// Largeur de bloc pour le format CSR par blocs (4 doubles = deux registres SSE2)
+#define SPARSE_BLOCK 4
+
+// Matrice creuse au format CSR par blocs (block_size = 1 -> CSR classique).
+// Chaque ligne stocke uniquement les blocs de `block_size` colonnes consécutives
+// contenant au moins une valeur non nulle.
+typedef struct {
+    int rows;
+    int cols;
+    int block_size;
+    int num_blocks;
+    int* row_ptr;     // rows + 1 entrées : blocs de la ligne i = [row_ptr[i], row_ptr[i+1])
+    int* block_col;   // Colonne de départ de chaque bloc
+    double* values;   // num_blocks * block_size valeurs (complétées par des zéros)
+} SparseMatrix;
+
+SparseMatrix dense_to_sparse(Matrix mat, int block_size) {
+    SparseMatrix sp = {mat.rows, mat.cols, block_size, 0, NULL, NULL, NULL};
+    int blocks_per_row = (mat.cols + block_size - 1) / block_size;
+
+    // 1. Compter les blocs non nuls
+    sp.row_ptr = malloc((mat.rows + 1) * sizeof(int));
+    if (sp.row_ptr == NULL) {
+        fprintf(stderr, "Erreur d'allocation mémoire !\n");
+        exit(1);
+    }
+    sp.row_ptr[0] = 0;
+    for (int i = 0; i < mat.rows; i++) {
+        int count = 0;
+        for (int b = 0; b < blocks_per_row; b++) {
+            for (int j = b * block_size; j < (b + 1) * block_size && j < mat.cols; j++) {
+                if (get_element(mat, i, j) != 0.0) {
+                    count++;
+                    break;
+                }
+            }
+        }
+        sp.row_ptr[i + 1] = sp.row_ptr[i] + count;
+    }
+    sp.num_blocks = sp.row_ptr[mat.rows];
+
+    // 2. Remplir les blocs
+    // (+1 pour éviter malloc(0) sur une matrice entièrement élaguée)
+    sp.block_col = malloc((sp.num_blocks + 1) * sizeof(int));
+    sp.values = calloc(sp.num_blocks * block_size + 1, sizeof(double));
+    if (sp.block_col == NULL || sp.values == NULL) {
+        fprintf(stderr, "Erreur d'allocation mémoire !\n");
+        exit(1);
+    }
+    int n = 0;
+    for (int i = 0; i < mat.rows; i++) {
+        for (int b = 0; b < blocks_per_row; b++) {
+            int start = b * block_size;
+            int non_zero = 0;
+            for (int j = start; j < start + block_size && j < mat.cols; j++) {
+                if (get_element(mat, i, j) != 0.0) {
+                    non_zero = 1;
+                    break;
+                }
+            }
+            if (!non_zero) continue;
+
+            sp.block_col[n] = start;
+            for (int j = start; j < start + block_size && j < mat.cols; j++) {
+                sp.values[n * block_size + (j - start)] = get_element(mat, i, j);
+            }
+            n++;
+        }
+    }
+    return sp;
+}
+
+void free_sparse_matrix(SparseMatrix *sp) {
+    free(sp->row_ptr);
+    free(sp->block_col);
+    free(sp->values);
+    sp->row_ptr = NULL;
+    sp->block_col = NULL;
+    sp->values = NULL;
+}
+
+// Taille en octets de la représentation creuse (ce qu'occuperait le checkpoint)
+long sparse_matrix_bytes(SparseMatrix sp) {
+    return (long)(sp.rows + 1) * sizeof(int)
+         + (long)sp.num_blocks * sizeof(int)
+         + (long)sp.num_blocks * sp.block_size * sizeof(double);
+}
+
+// out[0..SPARSE_BLOCK) += x * v[0..SPARSE_BLOCK)
+// `restrict` garantit au compilateur que out et v ne se chevauchent pas,
+// sans quoi il n'ose pas regrouper les 4 mises à jour en instructions SIMD.
+static inline void axpy_block(double *restrict out, const double *restrict v, double x) {
+    for (int k = 0; k < SPARSE_BLOCK; k++) {
+        out[k] += x * v[k];
+    }
+}
+
+// result = a * sp (a dense, sp creuse)
+// Chaque ligne de sp est mise à l'échelle par a[r][i] puis accumulée dans result :
+// les entrées nulles de a (pixels noirs, sorties ReLU éteintes) sont sautées.
+// Les blocs complets passent par axpy_block, vectorisé (vérifier avec -fopt-info-vec).
+void sparse_multiply(Matrix a, SparseMatrix sp, Matrix result) {
+    if (a.cols != sp.rows) {
+        fprintf(stderr, "Matrices incompatibles pour la multiplication creuse !\n");
+        fprintf(stderr, "A: %dx%d, B: %dx%d\n", a.rows, a.cols, sp.rows, sp.cols);
+        exit(1);
+    }
+    reset_matrix(result);
+    for (int r = 0; r < a.rows; r++) {
+        double *out_row = result.data + r * result.cols;
+        for (int i = 0; i < sp.rows; i++) {
+            double x = get_element(a, r, i);
+            if (x == 0.0) continue;
+
+            for (int b = sp.row_ptr[i]; b < sp.row_ptr[i + 1]; b++) {
+                int col = sp.block_col[b];
+                double *out = out_row + col;
+                const double *v = sp.values + b * sp.block_size;
+                if (sp.block_size == SPARSE_BLOCK && col + SPARSE_BLOCK <= sp.cols) {
+                    axpy_block(out, v, x);
+                } else {
+                    int width = (col + sp.block_size <= sp.cols) ? sp.block_size : sp.cols - col;
+                    for (int k = 0; k < width; k++) {
+                        out[k] += x * v[k];
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Réseau d'inférence : réutilise les biais et buffers des couches du Network,
+// seuls les poids sont remplacés par leur version creuse.
+typedef struct {
+    Network* net;
+    SparseMatrix* weights;
+    int num_layers;
+} SparseNetwork;
+
+SparseNetwork create_sparse_network(Network *net, int block_size) {
+    SparseNetwork snet;
+    snet.net = net;
+    snet.num_layers = net->num_layers;
+    snet.weights = malloc(snet.num_layers * sizeof(SparseMatrix));
+    if (snet.weights == NULL) {
+        fprintf(stderr, "Erreur d'allocation mémoire pour les couches !\n");
+        exit(1);
+    }
+    for (int i = 0; i < snet.num_layers; i++) {
+        snet.weights[i] = dense_to_sparse(net->layers[i].weights, block_size);
+    }
+    return snet;
+}
+
+void free_sparse_network(SparseNetwork *snet) {
+    for (int i = 0; i < snet->num_layers; i++) {
+        free_sparse_matrix(&snet->weights[i]);
+    }
+    free(snet->weights);
+    snet->weights = NULL;
+}
+
+long sparse_network_bytes(SparseNetwork snet) {
+    long bytes = 0;
+    for (int i = 0; i < snet.num_layers; i++) {
+        bytes += sparse_matrix_bytes(snet.weights[i]);
+        bytes += (long)snet.net->layers[i].biases.cols * sizeof(double);
+    }
+    return bytes;
+}
+
+long dense_network_bytes(Network net) {
+    long bytes = 0;
+    for (int i = 0; i < net.num_layers; i++) {
+        bytes += (long)net.layers[i].weights.rows * net.layers[i].weights.cols * sizeof(double);
+        bytes += (long)net.layers[i].biases.cols * sizeof(double);
+    }
+    return bytes;
+}
+
+void forward_layer_sparse(Layer *layer, SparseMatrix weights, Matrix input) {
+    // Même calcul que forward_layer, avec Z = Input * Poids_creux
+    sparse_multiply(input, weights, layer->z);
+    add_matrices(layer->z, layer->biases, layer->z);
+    apply_activation(layer);
+}
+
+void forward_sparse_network(SparseNetwork snet, Matrix input, Matrix output) {
+    Layer *layers = snet.net->layers;
+    forward_layer_sparse(&layers[0], snet.weights[0], input);
+    for (int i = 1; i < snet.num_layers; i++) {
+        forward_layer_sparse(&layers[i], snet.weights[i], layers[i-1].activation);
+    }
+    copy_matrix(layers[snet.num_layers - 1].activation, output);
+}
+
+#endif
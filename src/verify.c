@@ -0,0 +1,681 @@
+// Harnais de vérification différentielle des noyaux de calcul.
+// Chaque opération de matrix.c, sparse.c, forward_layer et la backpropagation
+// de train_network est comparée à une implémentation de référence naïve sur des
+// tailles aléatoires (y compris impaires / non multiples de la largeur SIMD).
+// Les gradients de train_network sont aussi vérifiés par différences finies.
+//
+// Usage : ./src/verify [seed]   (code de retour 1 si un noyau dépasse sa tolérance)
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "sparse.c"
+
+#define TRIALS 40
+
+// Tailles testées : petites, impaires, et autour des multiples de 2/4/8
+static const int SIZES[] = {1, 2, 3, 4, 5, 7, 8, 9, 13, 15, 16, 17, 31, 32, 33, 63, 64, 65, 127, 128, 129};
+static const int NUM_SIZES = sizeof(SIZES) / sizeof(SIZES[0]);
+
+typedef struct {
+    const char* name;
+    double tolerance;   // Erreur relative maximale acceptée
+    double max_rel;     // Pire erreur relative observée
+    double max_ulp;     // Pire écart en ULP de la valeur de référence (cf. record)
+    long comparisons;
+    int no_ulp;         // 1 : écart en ULP non affiché (erreur de troncature, pas d'arrondi)
+} KernelReport;
+
+// Index de chaque noyau dans le tableau des rapports
+enum {
+    K_COPY,
+    K_ADD,
+    K_SUBSTRACT,
+    K_ELEMENTWISE,
+    K_SCALAR,
+    K_TRANSPOSE,
+    K_MIN_MAX,
+    K_RESET,
+    K_MULTIPLY,
+    K_SPARSE_CSR,
+    K_SPARSE_BCSR,
+    K_FORWARD,
+    K_FORWARD_SPARSE,
+    K_BACKPROP,
+    K_UPDATE,
+    K_GRADCHECK,
+    NUM_KERNELS
+};
+
+// ---------------------------------------------------------------------------
+// Mesure d'erreur
+// ---------------------------------------------------------------------------
+
+// Taille d'un ULP à l'ordre de grandeur x
+static double ulp_of(double x) {
+    x = fabs(x);
+    return nextafter(x, INFINITY) - x;
+}
+
+// scale : ordre de grandeur de la valeur attendue. Pour une réduction (somme de
+// produits) on passe la somme des |termes|, sinon une annulation rendrait
+// l'erreur relative arbitrairement grande. L'écart en ULP est mesuré à la même
+// échelle : pour un noyau exact (scale = 0) c'est l'écart en ULP habituel.
+static void record(KernelReport *r, double got, double expected, double scale) {
+    double err = fabs(got - expected);
+    double denom = fmax(fabs(expected), scale);
+    double rel = (denom > 0.0) ? err / denom : err;
+    double ulp = (err == 0.0) ? 0.0 : err / ulp_of(denom);
+    if (isnan(got) != isnan(expected)) rel = ulp = INFINITY;
+
+    if (rel > r->max_rel) r->max_rel = rel;
+    if (ulp > r->max_ulp) r->max_ulp = ulp;
+    r->comparisons++;
+}
+
+static void record_matrix(KernelReport *r, Matrix got, Matrix expected) {
+    for (int i = 0; i < got.rows * got.cols; i++) {
+        record(r, got.data[i], expected.data[i], 0.0);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Données aléatoires
+// ---------------------------------------------------------------------------
+
+static int random_size() {
+    return SIZES[rand() % NUM_SIZES];
+}
+
+static double uniform(double lo, double hi) {
+    return lo + (hi - lo) * ((double)rand() / RAND_MAX);
+}
+
+// zero_fraction : proportion d'éléments mis à zéro (simule pixels noirs / ReLU / élagage)
+static Matrix random_matrix(int rows, int cols, double zero_fraction) {
+    Matrix m = create_matrix(rows, cols, 1);
+    for (int i = 0; i < rows * cols; i++) {
+        m.data[i] = (uniform(0.0, 1.0) < zero_fraction) ? 0.0 : uniform(-2.0, 2.0);
+    }
+    return m;
+}
+
+// ---------------------------------------------------------------------------
+// Implémentations de référence (boucles naïves, accumulations en long double)
+// ---------------------------------------------------------------------------
+
+// result = a * b, scale[i][j] = sum_k |a_ik * b_kj|
+static void ref_multiply(Matrix a, Matrix b, Matrix result, Matrix scale) {
+    for (int i = 0; i < a.rows; i++) {
+        for (int j = 0; j < b.cols; j++) {
+            long double sum = 0.0L;
+            long double abs_sum = 0.0L;
+            for (int k = 0; k < a.cols; k++) {
+                long double p = (long double)a.data[i * a.cols + k] * b.data[k * b.cols + j];
+                sum += p;
+                abs_sum += fabsl(p);
+            }
+            result.data[i * result.cols + j] = (double)sum;
+            scale.data[i * scale.cols + j] = (double)abs_sum;
+        }
+    }
+}
+
+static void record_reduction(KernelReport *r, Matrix got, Matrix expected, Matrix scale) {
+    for (int i = 0; i < got.rows * got.cols; i++) {
+        record(r, got.data[i], expected.data[i], scale.data[i]);
+    }
+}
+
+// a = f(z) (softmax si use_softmax)
+static void ref_activation(Matrix z, ActivationFunc f, int use_softmax, Matrix a) {
+    if (use_softmax) {
+        double max_val = z.data[0];
+        for (int j = 1; j < z.cols; j++) {
+            if (z.data[j] > max_val) max_val = z.data[j];
+        }
+        long double sum = 0.0L;
+        for (int j = 0; j < z.cols; j++) {
+            sum += expl((long double)z.data[j] - max_val);
+        }
+        for (int j = 0; j < z.cols; j++) {
+            a.data[j] = (double)(expl((long double)z.data[j] - max_val) / sum);
+        }
+    } else {
+        for (int j = 0; j < z.cols; j++) {
+            a.data[j] = f(z.data[j]);
+        }
+    }
+}
+
+// z = x * W + b puis a = f(z)
+static void ref_forward(Matrix x, Matrix w, Matrix b, ActivationFunc f, int use_softmax,
+                        Matrix z, Matrix a, Matrix scale) {
+    ref_multiply(x, w, z, scale);
+    for (int j = 0; j < z.cols; j++) {
+        z.data[j] += b.data[j];
+        scale.data[j] += fabs(b.data[j]);
+    }
+    ref_activation(z, f, use_softmax, a);
+}
+
+// ---------------------------------------------------------------------------
+// Noyaux de matrix.c
+// ---------------------------------------------------------------------------
+
+static void check_matrix_ops(KernelReport *reports) {
+    for (int t = 0; t < TRIALS; t++) {
+        int rows = random_size();
+        int cols = random_size();
+        Matrix a = random_matrix(rows, cols, 0.1);
+        Matrix b = random_matrix(rows, cols, 0.1);
+        Matrix got = create_matrix(rows, cols, 0);
+        Matrix expected = create_matrix(rows, cols, 0);
+        double s = uniform(-3.0, 3.0);
+
+        copy_matrix(a, got);
+        record_matrix(&reports[K_COPY], got, a);
+
+        add_matrices(a, b, got);
+        for (int i = 0; i < rows * cols; i++) expected.data[i] = a.data[i] + b.data[i];
+        record_matrix(&reports[K_ADD], got, expected);
+
+        substract_matrices(a, b, got);
+        for (int i = 0; i < rows * cols; i++) expected.data[i] = a.data[i] - b.data[i];
+        record_matrix(&reports[K_SUBSTRACT], got, expected);
+
+        elementwise_multiply_matrix(a, b, got);
+        for (int i = 0; i < rows * cols; i++) expected.data[i] = a.data[i] * b.data[i];
+        record_matrix(&reports[K_ELEMENTWISE], got, expected);
+
+        scalar_multiply_matrix(a, s, got);
+        for (int i = 0; i < rows * cols; i++) expected.data[i] = a.data[i] * s;
+        record_matrix(&reports[K_SCALAR], got, expected);
+
+        // Appels en place (result == premier argument), comme dans layer.c et
+        // train_network : une variante qui suppose l'absence d'aliasing doit échouer ici.
+        copy_matrix(a, got);
+        add_matrices(got, b, got);
+        for (int i = 0; i < rows * cols; i++) expected.data[i] = a.data[i] + b.data[i];
+        record_matrix(&reports[K_ADD], got, expected);
+
+        copy_matrix(a, got);
+        substract_matrices(got, b, got);
+        for (int i = 0; i < rows * cols; i++) expected.data[i] = a.data[i] - b.data[i];
+        record_matrix(&reports[K_SUBSTRACT], got, expected);
+
+        copy_matrix(a, got);
+        elementwise_multiply_matrix(got, b, got);
+        for (int i = 0; i < rows * cols; i++) expected.data[i] = a.data[i] * b.data[i];
+        record_matrix(&reports[K_ELEMENTWISE], got, expected);
+
+        copy_matrix(a, got);
+        scalar_multiply_matrix(got, s, got);
+        for (int i = 0; i < rows * cols; i++) expected.data[i] = a.data[i] * s;
+        record_matrix(&reports[K_SCALAR], got, expected);
+
+        Matrix t_got = create_matrix(cols, rows, 0);
+        Matrix t_expected = create_matrix(cols, rows, 0);
+        transpose_matrix(a, t_got);
+        for (int i = 0; i < rows; i++) {
+            for (int j = 0; j < cols; j++) {
+                t_expected.data[j * rows + i] = a.data[i * cols + j];
+            }
+        }
+        record_matrix(&reports[K_TRANSPOSE], t_got, t_expected);
+
+        double max_val = a.data[0];
+        double min_val = a.data[0];
+        for (int i = 1; i < rows * cols; i++) {
+            if (a.data[i] > max_val) max_val = a.data[i];
+            if (a.data[i] < min_val) min_val = a.data[i];
+        }
+        record(&reports[K_MIN_MAX], max_matrix(a), max_val, 0.0);
+        record(&reports[K_MIN_MAX], min_matrix(a), min_val, 0.0);
+
+        copy_matrix(a, got);
+        reset_matrix(got);
+        reset_matrix(expected);
+        record_matrix(&reports[K_RESET], got, expected);
+
+        free_matrix(&a);
+        free_matrix(&b);
+        free_matrix(&got);
+        free_matrix(&expected);
+        free_matrix(&t_got);
+        free_matrix(&t_expected);
+    }
+}
+
+// multiply_matrices et sparse_multiply (CSR et CSR par blocs) contre la référence
+static void check_products(KernelReport *reports) {
+    KernelReport *dense = &reports[K_MULTIPLY];
+    KernelReport *csr = &reports[K_SPARSE_CSR];
+    KernelReport *bcsr = &reports[K_SPARSE_BCSR];
+
+    for (int t = 0; t < TRIALS; t++) {
+        int m = (t % 4 == 0) ? random_size() : 1; // Surtout des vecteurs ligne (cas de l'inférence)
+        int k = random_size();
+        int n = random_size();
+        double sparsity = uniform(0.0, 0.99);
+        Matrix a = random_matrix(m, k, 0.5);
+        Matrix b = random_matrix(k, n, sparsity);
+        Matrix got = create_matrix(m, n, 0);
+        Matrix expected = create_matrix(m, n, 0);
+        Matrix scale = create_matrix(m, n, 0);
+        ref_multiply(a, b, expected, scale);
+
+        multiply_matrices(a, b, got);
+        record_reduction(dense, got, expected, scale);
+
+        SparseMatrix sp = dense_to_sparse(b, 1);
+        sparse_multiply(a, sp, got);
+        record_reduction(csr, got, expected, scale);
+        free_sparse_matrix(&sp);
+
+        sp = dense_to_sparse(b, SPARSE_BLOCK);
+        sparse_multiply(a, sp, got);
+        record_reduction(bcsr, got, expected, scale);
+        free_sparse_matrix(&sp);
+
+        free_matrix(&a);
+        free_matrix(&b);
+        free_matrix(&got);
+        free_matrix(&expected);
+        free_matrix(&scale);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// forward_layer / forward_layer_sparse
+// ---------------------------------------------------------------------------
+
+static void check_forward(KernelReport *reports) {
+    KernelReport *dense = &reports[K_FORWARD];
+    KernelReport *sparse = &reports[K_FORWARD_SPARSE];
+
+    ActivationFunc funcs[] = {relu, sigmoid, softmax_placeholder};
+    int softmax[] = {0, 0, 1};
+
+    for (int t = 0; t < TRIALS; t++) {
+        int in = random_size();
+        int out = random_size();
+        int kind = t % 3;
+        Layer layer = create_layer(in, out, funcs[kind], softmax[kind]);
+        Matrix x = random_matrix(1, in, 0.3);
+        Matrix z = create_matrix(1, out, 0);
+        Matrix a = create_matrix(1, out, 0);
+        Matrix scale = create_matrix(1, out, 0);
+        ref_forward(x, layer.weights, layer.biases, layer.func, layer.use_softmax, z, a, scale);
+
+        // L'activation est comparée à la référence appliquée au Z du noyau :
+        // exp / sigmoid amplifieraient sinon l'erreur d'arrondi de la réduction.
+        forward_layer(&layer, x);
+        record_reduction(dense, layer.z, z, scale);
+        ref_activation(layer.z, layer.func, layer.use_softmax, a);
+        record_matrix(dense, layer.activation, a);
+
+        prune_layer(&layer, 0.5); // Les poids |w| <= 0.5 sont élagués, la référence suit
+        ref_forward(x, layer.weights, layer.biases, layer.func, layer.use_softmax, z, a, scale);
+        SparseMatrix sp = dense_to_sparse(layer.weights, (t % 2) ? SPARSE_BLOCK : 1);
+        forward_layer_sparse(&layer, sp, x);
+        record_reduction(sparse, layer.z, z, scale);
+        ref_activation(layer.z, layer.func, layer.use_softmax, a);
+        record_matrix(sparse, layer.activation, a);
+
+        free_sparse_matrix(&sp);
+        free_layer(&layer);
+        free_matrix(&x);
+        free_matrix(&z);
+        free_matrix(&a);
+        free_matrix(&scale);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Backpropagation
+// ---------------------------------------------------------------------------
+
+// Réseau aléatoire : couches cachées ReLU ou Sigmoid, sortie Softmax ou Sigmoid
+static Network random_network(int *sizes, int num_sizes, int max_size, int softmax_output) {
+    ActivationFunc activations[4];
+    int use_softmax[4];
+    for (int i = 0; i < num_sizes; i++) {
+        sizes[i] = 1 + rand() % max_size;
+    }
+    if (softmax_output && sizes[num_sizes - 1] < 2) sizes[num_sizes - 1] = 2;
+    for (int i = 0; i < num_sizes - 1; i++) {
+        activations[i] = (rand() % 2) ? relu : sigmoid;
+        use_softmax[i] = 0;
+    }
+    if (softmax_output) {
+        activations[num_sizes - 2] = softmax_placeholder;
+        use_softmax[num_sizes - 2] = 1;
+    }
+    return create_network(sizes, num_sizes, activations, use_softmax);
+}
+
+static Matrix random_target(int size, int one_hot) {
+    Matrix y = create_matrix(1, size, 0);
+    if (one_hot) {
+        y.data[rand() % size] = 1.0;
+    } else {
+        for (int j = 0; j < size; j++) y.data[j] = uniform(0.0, 1.0);
+    }
+    return y;
+}
+
+// Perte associée au delta de sortie de train_network :
+// Softmax -> entropie croisée, sinon -> 0.5 * ||a - y||^2
+static double network_loss(Network net, Matrix x, Matrix y) {
+    Matrix out = create_matrix(1, y.cols, 0);
+    forward_network(net, x, out);
+    double loss = 0.0;
+    for (int j = 0; j < y.cols; j++) {
+        if (net.layers[net.num_layers - 1].use_softmax) {
+            if (y.data[j] > 0.0) loss -= y.data[j] * log(out.data[j]);
+        } else {
+            double d = out.data[j] - y.data[j];
+            loss += 0.5 * d * d;
+        }
+    }
+    free_matrix(&out);
+    return loss;
+}
+
+static double max_abs(Matrix m) {
+    double max_val = 0.0;
+    for (int i = 0; i < m.rows * m.cols; i++) {
+        if (fabs(m.data[i]) > max_val) max_val = fabs(m.data[i]);
+    }
+    return max_val;
+}
+
+// Gradients de référence calculés indépendamment (forward + backward naïfs)
+static void ref_gradients(Network net, Matrix x, Matrix y, Matrix *grad_w, Matrix *grad_b) {
+    int n = net.num_layers;
+    Matrix *z = malloc(n * sizeof(Matrix));
+    Matrix *a = malloc(n * sizeof(Matrix));
+    Matrix *delta = malloc(n * sizeof(Matrix));
+
+    for (int l = 0; l < n; l++) {
+        Layer *layer = &net.layers[l];
+        int out = layer->weights.cols;
+        z[l] = create_matrix(1, out, 0);
+        a[l] = create_matrix(1, out, 0);
+        delta[l] = create_matrix(1, out, 0);
+        Matrix scale = create_matrix(1, out, 0);
+        ref_forward((l == 0) ? x : a[l - 1], layer->weights, layer->biases, layer->func, layer->use_softmax, z[l], a[l], scale);
+        free_matrix(&scale);
+    }
+
+    for (int l = n - 1; l >= 0; l--) {
+        Layer *layer = &net.layers[l];
+        for (int j = 0; j < layer->weights.cols; j++) {
+            double error;
+            if (l == n - 1) {
+                error = a[l].data[j] - y.data[j];
+            } else {
+                Matrix w_next = net.layers[l + 1].weights;
+                long double sum = 0.0L;
+                for (int k = 0; k < w_next.cols; k++) {
+                    sum += (long double)delta[l + 1].data[k] * w_next.data[j * w_next.cols + k];
+                }
+                error = (double)sum;
+            }
+            delta[l].data[j] = layer->use_softmax ? error : error * layer->deriv(z[l].data[j]);
+        }
+
+        Matrix input = (l == 0) ? x : a[l - 1];
+        for (int i = 0; i < layer->weights.rows; i++) {
+            for (int j = 0; j < layer->weights.cols; j++) {
+                grad_w[l].data[i * grad_w[l].cols + j] = input.data[i] * delta[l].data[j];
+            }
+        }
+        copy_matrix(delta[l], grad_b[l]);
+    }
+
+    for (int l = 0; l < n; l++) {
+        free_matrix(&z[l]);
+        free_matrix(&a[l]);
+        free_matrix(&delta[l]);
+    }
+    free(z);
+    free(a);
+    free(delta);
+}
+
+// Les gradients accumulés par train_network (sans mise à jour : batch non terminé)
+// sont comparés aux gradients de référence puis aux différences finies de la perte.
+static void check_backprop(KernelReport *reports) {
+    KernelReport *backprop = &reports[K_BACKPROP];
+    KernelReport *gradcheck = &reports[K_GRADCHECK];
+    const double eps = 1e-6;
+
+    for (int t = 0; t < TRIALS; t++) {
+        int sizes[4];
+        int num_sizes = 3 + t % 2;
+        int softmax_output = t % 2 == 0;
+        Network net = random_network(sizes, num_sizes, 9, softmax_output);
+        Matrix x = random_matrix(1, sizes[0], 0.2);
+        Matrix y = random_target(sizes[num_sizes - 1], softmax_output);
+
+        train_network(&net, x, y, 0.1, 2, 0); // current_batch = 0, batch_size = 2 : pas de mise à jour
+
+        Matrix *grad_w = malloc(net.num_layers * sizeof(Matrix));
+        Matrix *grad_b = malloc(net.num_layers * sizeof(Matrix));
+        for (int l = 0; l < net.num_layers; l++) {
+            grad_w[l] = create_matrix(net.layers[l].weights.rows, net.layers[l].weights.cols, 0);
+            grad_b[l] = create_matrix(1, net.layers[l].weights.cols, 0);
+        }
+        ref_gradients(net, x, y, grad_w, grad_b);
+
+        for (int l = 0; l < net.num_layers; l++) {
+            Layer *layer = &net.layers[l];
+            // Erreur relative à la plus grande composante du gradient de la couche
+            double g_scale = fmax(max_abs(grad_w[l]), max_abs(grad_b[l]));
+            for (int i = 0; i < grad_w[l].rows * grad_w[l].cols; i++) {
+                record(backprop, layer->weight_gradients.data[i], grad_w[l].data[i], g_scale);
+            }
+            for (int j = 0; j < grad_b[l].cols; j++) {
+                record(backprop, layer->bias_gradients.data[j], grad_b[l].data[j], g_scale);
+            }
+
+            // Différences finies centrées sur chaque poids et biais
+            Matrix params[2] = {layer->weights, layer->biases};
+            Matrix grads[2] = {layer->weight_gradients, layer->bias_gradients};
+            for (int p = 0; p < 2; p++) {
+                for (int i = 0; i < params[p].rows * params[p].cols; i++) {
+                    double saved = params[p].data[i];
+                    params[p].data[i] = saved + eps;
+                    double loss_plus = network_loss(net, x, y);
+                    params[p].data[i] = saved - eps;
+                    double loss_minus = network_loss(net, x, y);
+                    params[p].data[i] = saved;
+
+                    double numeric = (loss_plus - loss_minus) / (2.0 * eps);
+                    record(gradcheck, grads[p].data[i], numeric, 1e-3);
+                }
+            }
+        }
+
+        for (int l = 0; l < net.num_layers; l++) {
+            free_matrix(&grad_w[l]);
+            free_matrix(&grad_b[l]);
+        }
+        free(grad_w);
+        free(grad_b);
+        free_matrix(&x);
+        free_matrix(&y);
+        free_network(&net);
+    }
+}
+
+// Un batch complet passe par train_network : accumulation des gradients sur
+// batch_size échantillons, puis mise à jour W -= lr/batch_size * sum(dW),
+// B -= lr/batch_size * sum(dB), masque d'élagage, t_weights et remise à zéro
+// des gradients. Le résultat est comparé à une mise à jour de référence.
+static void check_update(KernelReport *reports) {
+    KernelReport *update = &reports[K_UPDATE];
+
+    for (int t = 0; t < TRIALS; t++) {
+        int sizes[4];
+        int num_sizes = 3 + t % 2;
+        int softmax_output = t % 2 == 0;
+        Network net = random_network(sizes, num_sizes, 9, softmax_output);
+        int n = net.num_layers;
+        int batch_size = 2 + rand() % 4;
+        double learning_rate = uniform(0.01, 0.5);
+
+        // Une couche élaguée à environ la moitié de sa magnitude maximale
+        Layer *pruned = &net.layers[rand() % n];
+        prune_layer(pruned, 0.5 * max_abs(pruned->weights));
+
+        Matrix *w0 = malloc(n * sizeof(Matrix));
+        Matrix *b0 = malloc(n * sizeof(Matrix));
+        Matrix *sum_w = malloc(n * sizeof(Matrix));
+        Matrix *sum_b = malloc(n * sizeof(Matrix));
+        Matrix *sum_abs_w = malloc(n * sizeof(Matrix)); // Somme des |gradients| par échantillon
+        Matrix *sum_abs_b = malloc(n * sizeof(Matrix));
+        Matrix *grad_w = malloc(n * sizeof(Matrix));
+        Matrix *grad_b = malloc(n * sizeof(Matrix));
+        for (int l = 0; l < n; l++) {
+            Matrix w = net.layers[l].weights;
+            w0[l] = create_matrix(w.rows, w.cols, 0);
+            b0[l] = create_matrix(1, w.cols, 0);
+            copy_matrix(w, w0[l]);
+            copy_matrix(net.layers[l].biases, b0[l]);
+            sum_w[l] = create_matrix(w.rows, w.cols, 0);
+            sum_b[l] = create_matrix(1, w.cols, 0);
+            sum_abs_w[l] = create_matrix(w.rows, w.cols, 0);
+            sum_abs_b[l] = create_matrix(1, w.cols, 0);
+            grad_w[l] = create_matrix(w.rows, w.cols, 0);
+            grad_b[l] = create_matrix(1, w.cols, 0);
+        }
+
+        // Les poids ne changent qu'à la fin du batch : les gradients de référence
+        // de chaque échantillon sont calculés sur l'état courant du réseau.
+        int counter = 0;
+        for (int k = 0; k < batch_size; k++) {
+            Matrix x = random_matrix(1, sizes[0], 0.2);
+            Matrix y = random_target(sizes[num_sizes - 1], softmax_output);
+            ref_gradients(net, x, y, grad_w, grad_b);
+            for (int l = 0; l < n; l++) {
+                for (int i = 0; i < grad_w[l].rows * grad_w[l].cols; i++) {
+                    sum_w[l].data[i] += grad_w[l].data[i];
+                    sum_abs_w[l].data[i] += fabs(grad_w[l].data[i]);
+                }
+                for (int j = 0; j < grad_b[l].cols; j++) {
+                    sum_b[l].data[j] += grad_b[l].data[j];
+                    sum_abs_b[l].data[j] += fabs(grad_b[l].data[j]);
+                }
+            }
+            counter = train_network(&net, x, y, learning_rate, batch_size, counter);
+            record(update, counter, (k + 1) % batch_size, 0.0); // Compteur de batch
+            free_matrix(&x);
+            free_matrix(&y);
+        }
+
+        double step = learning_rate / batch_size;
+        for (int l = 0; l < n; l++) {
+            Layer *layer = &net.layers[l];
+            Matrix w = layer->weights;
+            // Comme dans check_backprop : l'erreur sur le pas est rapportée à la plus
+            // grande somme de |gradients| de la couche, car les gradients des
+            // échantillons d'un batch peuvent s'annuler (deltas softmax, biais nuls).
+            double g_scale = step * fmax(max_abs(sum_abs_w[l]), max_abs(sum_abs_b[l]));
+            for (int i = 0; i < w.rows * w.cols; i++) {
+                double keep = (layer->mask.data == NULL) ? 1.0 : layer->mask.data[i];
+                double expected = (w0[l].data[i] - step * sum_w[l].data[i]) * keep;
+                double scale = keep * (fabs(w0[l].data[i]) + g_scale);
+                record(update, w.data[i], expected, scale);
+
+                // t_weights doit être la transposée exacte des poids mis à jour
+                int row = i / w.cols;
+                int col = i % w.cols;
+                record(update, get_element(layer->t_weights, col, row), w.data[i], 0.0);
+
+                record(update, layer->weight_gradients.data[i], 0.0, 0.0);
+            }
+            for (int j = 0; j < w.cols; j++) {
+                double expected = b0[l].data[j] - step * sum_b[l].data[j];
+                double scale = fabs(b0[l].data[j]) + g_scale;
+                record(update, layer->biases.data[j], expected, scale);
+                record(update, layer->bias_gradients.data[j], 0.0, 0.0);
+            }
+        }
+
+        for (int l = 0; l < n; l++) {
+            free_matrix(&w0[l]);
+            free_matrix(&b0[l]);
+            free_matrix(&sum_w[l]);
+            free_matrix(&sum_b[l]);
+            free_matrix(&sum_abs_w[l]);
+            free_matrix(&sum_abs_b[l]);
+            free_matrix(&grad_w[l]);
+            free_matrix(&grad_b[l]);
+        }
+        free(w0);
+        free(b0);
+        free(sum_w);
+        free(sum_b);
+        free(sum_abs_w);
+        free(sum_abs_b);
+        free(grad_w);
+        free(grad_b);
+        free_network(&net);
+    }
+}
+
+int main(int argc, char **argv) {
+    unsigned int seed = (argc > 1) ? (unsigned int)strtoul(argv[1], NULL, 10) : (unsigned int)time(NULL);
+    srand(seed);
+    printf("Vérification différentielle des noyaux (seed = %u)\n\n", seed);
+
+    // Tolérances : 0 pour les opérations exactes élément par élément,
+    // quelques epsilon relatifs à sum|termes| pour les réductions.
+    KernelReport reports[NUM_KERNELS] = {
+        [K_COPY]           = {"copy_matrix",                  0.0,   0, 0, 0},
+        [K_ADD]            = {"add_matrices",                 0.0,   0, 0, 0},
+        [K_SUBSTRACT]      = {"substract_matrices",           0.0,   0, 0, 0},
+        [K_ELEMENTWISE]    = {"elementwise_multiply_matrix",  0.0,   0, 0, 0},
+        [K_SCALAR]         = {"scalar_multiply_matrix",       0.0,   0, 0, 0},
+        [K_TRANSPOSE]      = {"transpose_matrix",             0.0,   0, 0, 0},
+        [K_MIN_MAX]        = {"max_matrix / min_matrix",      0.0,   0, 0, 0},
+        [K_RESET]          = {"reset_matrix",                 0.0,   0, 0, 0},
+        [K_MULTIPLY]       = {"multiply_matrices",            1e-13, 0, 0, 0},
+        [K_SPARSE_CSR]     = {"sparse_multiply (CSR)",        1e-13, 0, 0, 0},
+        [K_SPARSE_BCSR]    = {"sparse_multiply (BCSR)",       1e-13, 0, 0, 0},
+        [K_FORWARD]        = {"forward_layer",                1e-13, 0, 0, 0},
+        [K_FORWARD_SPARSE] = {"forward_layer_sparse",         1e-13, 0, 0, 0},
+        [K_BACKPROP]       = {"train_network (backprop)",     1e-12, 0, 0, 0},
+        [K_UPDATE]         = {"train_network (batch complet)", 1e-12, 0, 0, 0},
+        [K_GRADCHECK]      = {"train_network (diff. finies)", 1e-5,  0, 0, 0, 1},
+    };
+
+    check_matrix_ops(reports);
+    check_products(reports);
+    check_forward(reports);
+    check_backprop(reports);
+    check_update(reports);
+
+    int failures = 0;
+    printf("%-30s | %11s | %12s | %12s | %9s | %s\n", "Noyau", "Comparaisons", "Err. rel max", "Tolérance", "ULP max", "Statut");
+    for (int i = 0; i < NUM_KERNELS; i++) {
+        KernelReport r = reports[i];
+        int ok = r.max_rel <= r.tolerance;
+        failures += !ok;
+        char ulp[32] = "-";
+        if (!r.no_ulp) snprintf(ulp, sizeof(ulp), "%.1f", r.max_ulp);
+        printf("%-30s | %11ld | %12.3e | %12.3e | %9s | %s\n",
+               r.name, r.comparisons, r.max_rel, r.tolerance, ulp, ok ? "OK" : "ECHEC");
+    }
+
+    if (failures) {
+        printf("\n%d noyau(x) hors tolérance.\n", failures);
+        return 1;
+    }
+    printf("\nTous les noyaux sont conformes.\n");
+    return 0;
+}